@@ -1,4 +1,5 @@
 #include "DataEncoder.h"
+#include <algorithm>
 #include <cctype>
 #include <stdexcept>
 
@@ -40,7 +41,7 @@ std::vector<int> DataEncoder::getModeIndicator(EncodingMode mode) {
     return {0, 1, 0, 0}; // Default to BYTE
 }
 
-std::vector<int> DataEncoder::getCharacterCountIndicator(int count, EncodingMode mode, int version) {
+int DataEncoder::getCharacterCountBits(EncodingMode mode, int version) {
     int bitCount = 8; // Default for BYTE mode (versions 1-9)
     
     if (version <= 9) {
@@ -52,7 +53,11 @@ std::vector<int> DataEncoder::getCharacterCountIndicator(int count, EncodingMode
         }
     }
     
-    return intToBits(count, bitCount);
+    return bitCount;
+}
+
+std::vector<int> DataEncoder::getCharacterCountIndicator(int count, EncodingMode mode, int version) {
+    return intToBits(count, getCharacterCountBits(mode, version));
 }
 
 std::vector<int> DataEncoder::intToBits(int value, int bitCount) {
@@ -188,4 +193,79 @@ std::vector<int> DataEncoder::encodeData(const std::string& data,
     addPadding(bits, capacity);
     
     return bits;
-}
\ No newline at end of file
+}
+
+bool DataEncoder::decodeData(const std::vector<int>& codewords,
+                             int version,
+                             std::string& data) {
+    const int totalBits = static_cast<int>(codewords.size()) * 8;
+    int position = 0;
+    
+    // Read `count` bits MSB-first, or return -1 past the end of the codewords
+    auto readBits = [&](int count) {
+        if (position + count > totalBits) return -1;
+        int value = 0;
+        for (int i = 0; i < count; i++, position++) {
+            value = (value << 1) | ((codewords[position >> 3] >> (7 - (position & 7))) & 1);
+        }
+        return value;
+    };
+    
+    data.clear();
+    
+    // Segments run until the terminator or until capacity is used up
+    while (totalBits - position >= 4) {
+        int indicator = readBits(4);
+        if (indicator == 0) break;
+        
+        EncodingMode mode;
+        switch (indicator) {
+            case 1: mode = EncodingMode::NUMERIC;      break;
+            case 2: mode = EncodingMode::ALPHANUMERIC; break;
+            case 4: mode = EncodingMode::BYTE;         break;
+            default: return false;
+        }
+        
+        int count = readBits(getCharacterCountBits(mode, version));
+        if (count < 0) return false;
+        
+        switch (mode) {
+            case EncodingMode::NUMERIC:
+                for (int i = 0; i < count; i += 3) {
+                    int groupSize = std::min(3, count - i);
+                    int bitCount = (groupSize == 3) ? 10 : (groupSize == 2) ? 7 : 4;
+                    int value = readBits(bitCount);
+                    if (value < 0 || value >= (groupSize == 3 ? 1000 : groupSize == 2 ? 100 : 10)) {
+                        return false;
+                    }
+                    std::string digits = std::to_string(value);
+                    data.append(groupSize - digits.size(), '0');
+                    data += digits;
+                }
+                break;
+            case EncodingMode::ALPHANUMERIC:
+                for (int i = 0; i < count; i += 2) {
+                    if (i + 1 < count) {
+                        int value = readBits(11);
+                        if (value < 0 || value >= 45 * 45) return false;
+                        data += ALPHANUMERIC_CHARS[value / 45];
+                        data += ALPHANUMERIC_CHARS[value % 45];
+                    } else {
+                        int value = readBits(6);
+                        if (value < 0 || value >= 45) return false;
+                        data += ALPHANUMERIC_CHARS[value];
+                    }
+                }
+                break;
+            default:
+                for (int i = 0; i < count; i++) {
+                    int value = readBits(8);
+                    if (value < 0) return false;
+                    data += static_cast<char>(value);
+                }
+                break;
+        }
+    }
+    
+    return true;
+}
@@ -16,6 +16,14 @@ public:
                                        ErrorCorrectionLevel ecLevel,
                                        int version);
     
+    // Decode data codewords back into text; false if the segments are malformed
+    static bool decodeData(const std::vector<int>& codewords,
+                           int version,
+                           std::string& data);
+    
+    // Get capacity for version and error correction level
+    static int getCapacity(int version, ErrorCorrectionLevel ecLevel);
+    
 private:
     // Check if data can be encoded in specific mode
     static bool isNumeric(const std::string& data);
@@ -29,11 +37,9 @@ private:
     // Helper functions
     static std::vector<int> getModeIndicator(EncodingMode mode);
     static std::vector<int> getCharacterCountIndicator(int count, EncodingMode mode, int version);
+    static int getCharacterCountBits(EncodingMode mode, int version);
     static std::vector<int> intToBits(int value, int bitCount);
     static void addPadding(std::vector<int>& bits, int targetCapacity);
-    
-    // Get capacity for version and error correction level
-    static int getCapacity(int version, ErrorCorrectionLevel ecLevel);
 };
 
 #endif // DATAENCODER_H
\ No newline at end of file
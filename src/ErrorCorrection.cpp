@@ -1,4 +1,5 @@
 #include "ErrorCorrection.h"
+#include <algorithm>
 #include <stdexcept>
 
 // Convert bits to bytes
@@ -64,22 +65,40 @@ std::vector<int> ErrorCorrection::generateErrorCorrectionCodewords(
     return ec;
 }
 
+int ErrorCorrection::getECCodewordCount(ErrorCorrectionLevel ecLevel, int /* version */) {
+    int ecCodewords = 16; // Version 4, EC-M approx
+    if (ecLevel == ErrorCorrectionLevel::L) ecCodewords = 10;
+    if (ecLevel == ErrorCorrectionLevel::Q) ecCodewords = 24;
+    if (ecLevel == ErrorCorrectionLevel::H) ecCodewords = 28;
+    return ecCodewords;
+}
+
 // Public API
 std::vector<int> ErrorCorrection::addErrorCorrection(
     const std::vector<int>& dataBits,
     ErrorCorrectionLevel ecLevel,
-    int /* version */) {
-
+    int version) {
 
     auto dataBytes = bitsToBytes(dataBits);
 
-    int ecCodewords = 16; // Version 4, EC-M approx
-    if (ecLevel == ErrorCorrectionLevel::L) ecCodewords = 10;
-    if (ecLevel == ErrorCorrectionLevel::Q) ecCodewords = 24;
-    if (ecLevel == ErrorCorrectionLevel::H) ecCodewords = 28;
+    int ecCodewords = getECCodewordCount(ecLevel, version);
 
     auto ecBytes = generateErrorCorrectionCodewords(dataBytes, ecCodewords);
 
     dataBytes.insert(dataBytes.end(), ecBytes.begin(), ecBytes.end());
     return bytesToBits(dataBytes);
 }
+
+bool ErrorCorrection::checkErrorCorrection(
+    const std::vector<int>& codewords,
+    ErrorCorrectionLevel ecLevel,
+    int version) {
+
+    int ecCodewords = getECCodewordCount(ecLevel, version);
+    if (static_cast<int>(codewords.size()) <= ecCodewords) return false;
+
+    // Recompute the check codewords; any difference is a non-zero syndrome
+    std::vector<int> dataCodewords(codewords.begin(), codewords.end() - ecCodewords);
+    auto expected = generateErrorCorrectionCodewords(dataCodewords, ecCodewords);
+    return std::equal(expected.begin(), expected.end(), codewords.end() - ecCodewords);
+}
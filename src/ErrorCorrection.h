@@ -11,6 +11,14 @@ public:
                                                ErrorCorrectionLevel ecLevel,
                                                int version);
     
+    // Check data codewords followed by their EC codewords (zero syndrome)
+    static bool checkErrorCorrection(const std::vector<int>& codewords,
+                                     ErrorCorrectionLevel ecLevel,
+                                     int version);
+    
+    // Number of error correction codewords for version and level
+    static int getECCodewordCount(ErrorCorrectionLevel ecLevel, int version);
+    
 private:
     // Convert bits to bytes
     static std::vector<int> bitsToBytes(const std::vector<int>& bits);
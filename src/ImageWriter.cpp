@@ -0,0 +1,262 @@
+#include "ImageWriter.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// Deflate length and distance code tables (RFC 1951, section 3.2.5)
+static const int LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const int LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const int DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+static const int DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const int MAX_MATCH = 258;
+static const int MAX_DISTANCE = 32768;
+static const size_t IDAT_SIZE = 1 << 16;
+
+static uint32_t crc32(const char* type, const uint8_t* data, size_t length) {
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int i = 0; i < 4; i++) {
+        crc = table[(crc ^ (uint8_t)type[i]) & 0xFF] ^ (crc >> 8);
+    }
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void appendUint32(std::vector<uint8_t>& bytes, uint32_t value) {
+    bytes.push_back((value >> 24) & 0xFF);
+    bytes.push_back((value >> 16) & 0xFF);
+    bytes.push_back((value >> 8) & 0xFF);
+    bytes.push_back(value & 0xFF);
+}
+
+ImageWriter::ImageWriter(std::ostream& out, ImageFormat format, int width, int height)
+    : out(out), format(format), width(width), height(height),
+      rowBytes(width > 0 ? (width - 1) / 8 + 1 : 0), rowsWritten(0),
+      bitBuffer(0), bitCount(0), adlerA(1), adlerB(0) {
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("Image dimensions must be positive");
+    }
+
+    if (format == ImageFormat::PBM) {
+        out << "P4\n" << width << " " << height << "\n";
+        return;
+    }
+
+    // Whole-row back-references must fit in the deflate window
+    if (rowBytes + 1 > MAX_DISTANCE) {
+        throw std::runtime_error("Image too wide for PNG output");
+    }
+    line.resize(rowBytes + 1);
+    writePngHeader();
+}
+
+void ImageWriter::writePngHeader() {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> ihdr;
+    appendUint32(ihdr, width);
+    appendUint32(ihdr, height);
+    ihdr.push_back(1);  // Bit depth
+    ihdr.push_back(0);  // Grayscale
+    ihdr.push_back(0);  // Deflate
+    ihdr.push_back(0);  // Adaptive filtering
+    ihdr.push_back(0);  // No interlace
+    writeChunk("IHDR", ihdr.data(), ihdr.size());
+
+    // zlib header (deflate, 32K window), then a single final fixed-Huffman block
+    pending.push_back(0x78);
+    pending.push_back(0x01);
+    putBits(1, 1);
+    putBits(1, 2);
+}
+
+void ImageWriter::writeChunk(const char* type, const uint8_t* data, size_t length) {
+    std::vector<uint8_t> header;
+    appendUint32(header, length);
+    header.insert(header.end(), type, type + 4);
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    out.write(reinterpret_cast<const char*>(data), length);
+
+    std::vector<uint8_t> crc;
+    appendUint32(crc, crc32(type, data, length));
+    out.write(reinterpret_cast<const char*>(crc.data()), crc.size());
+    if (!out) throw std::runtime_error("Could not write image");
+}
+
+void ImageWriter::flushPending(size_t threshold) {
+    if (!pending.empty() && pending.size() >= threshold) {
+        writeChunk("IDAT", pending.data(), pending.size());
+        pending.clear();
+    }
+}
+
+void ImageWriter::putBits(uint32_t value, int count) {
+    // Deflate packs data elements starting at the least significant bit
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+        pending.push_back(bitBuffer & 0xFF);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+void ImageWriter::putCode(uint32_t code, int length) {
+    // Huffman codes are packed starting at their most significant bit
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    putBits(reversed, length);
+}
+
+void ImageWriter::putLiteral(int value) {
+    // Fixed Huffman literal/length alphabet
+    if (value < 144) {
+        putCode(0x30 + value, 8);
+    } else if (value < 256) {
+        putCode(0x190 + (value - 144), 9);
+    } else if (value < 280) {
+        putCode(value - 256, 7);
+    } else {
+        putCode(0xC0 + (value - 280), 8);
+    }
+}
+
+void ImageWriter::putMatch(int length, int distance) {
+    int lengthCode = 28;
+    while (LENGTH_BASE[lengthCode] > length) lengthCode--;
+    putLiteral(257 + lengthCode);
+    putBits(length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+    int distanceCode = 29;
+    while (DISTANCE_BASE[distanceCode] > distance) distanceCode--;
+    putCode(distanceCode, 5);
+    putBits(distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+}
+
+void ImageWriter::deflateLine() {
+    // Two match candidates are enough for label sheets: the same bytes one
+    // scanline up (module scale and quiet zones repeat whole rows) and a
+    // run of the previous byte (wide dark or light stretches).
+    const int length = static_cast<int>(line.size());
+    const bool hasPrev = !prevLine.empty();
+
+    int i = 0;
+    while (i < length) {
+        int upLength = 0;
+        if (hasPrev) {
+            while (i + upLength < length && upLength < MAX_MATCH &&
+                   line[i + upLength] == prevLine[i + upLength]) {
+                upLength++;
+            }
+        }
+
+        int runLength = 0;
+        if (i > 0) {
+            while (i + runLength < length && runLength < MAX_MATCH &&
+                   line[i + runLength] == line[i - 1]) {
+                runLength++;
+            }
+        }
+
+        if (upLength >= 3 && upLength >= runLength) {
+            putMatch(upLength, length);
+            i += upLength;
+        } else if (runLength >= 3) {
+            putMatch(runLength, 1);
+            i += runLength;
+        } else {
+            putLiteral(line[i]);
+            i++;
+        }
+    }
+}
+
+void ImageWriter::updateAdler(const std::vector<uint8_t>& data) {
+    // Reduce modulo 65521 only as often as needed to avoid overflow
+    size_t i = 0;
+    while (i < data.size()) {
+        size_t end = std::min(data.size(), i + 5552);
+        for (; i < end; i++) {
+            adlerA += data[i];
+            adlerB += adlerA;
+        }
+        adlerA %= 65521;
+        adlerB %= 65521;
+    }
+}
+
+void ImageWriter::writeRow(const std::vector<uint8_t>& row) {
+    if (static_cast<int>(row.size()) != rowBytes) {
+        throw std::runtime_error("Scanline has wrong length");
+    }
+    if (rowsWritten >= height) {
+        throw std::runtime_error("Too many scanlines for image");
+    }
+    rowsWritten++;
+
+    if (format == ImageFormat::PBM) {
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+        if (!out) throw std::runtime_error("Could not write image");
+        return;
+    }
+
+    // Filter type None; PNG grayscale uses 0 for black
+    line[0] = 0;
+    for (int i = 0; i < rowBytes; i++) {
+        line[i + 1] = ~row[i];
+    }
+
+    deflateLine();
+    updateAdler(line);
+    prevLine.swap(line);
+    line.resize(rowBytes + 1);
+    flushPending(IDAT_SIZE);
+}
+
+void ImageWriter::finish() {
+    if (rowsWritten != height) {
+        throw std::runtime_error("Image has " + std::to_string(rowsWritten) +
+                                 " of " + std::to_string(height) + " scanlines");
+    }
+
+    if (format == ImageFormat::PNG) {
+        putLiteral(256);  // End of block
+        if (bitCount > 0) putBits(0, 8 - bitCount);
+        appendUint32(pending, (adlerB << 16) | adlerA);
+        flushPending(0);
+        writeChunk("IEND", nullptr, 0);
+    }
+
+    out.flush();
+    if (!out) throw std::runtime_error("Could not write image");
+}
@@ -0,0 +1,59 @@
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+enum class ImageFormat {
+    PBM,  // Binary portable bitmap (P4)
+    PNG   // 1-bit grayscale PNG
+};
+
+// Writes a bilevel image one scanline at a time. PBM holds nothing beyond
+// the caller's scanline; PNG also keeps the previous scanline and up to
+// 64 KiB of compressed data waiting to be flushed as an IDAT chunk.
+class ImageWriter {
+private:
+    std::ostream& out;
+    ImageFormat format;
+    int width;
+    int height;
+    int rowBytes;
+    int rowsWritten;
+
+    // PNG state: filtered scanlines, deflate bit buffer and checksums
+    std::vector<uint8_t> line;
+    std::vector<uint8_t> prevLine;
+    std::vector<uint8_t> pending;
+    uint32_t bitBuffer;
+    int bitCount;
+    uint32_t adlerA;
+    uint32_t adlerB;
+
+    // PNG container
+    void writePngHeader();
+    void writeChunk(const char* type, const uint8_t* data, size_t length);
+    void flushPending(size_t threshold);
+
+    // Fixed-Huffman deflate
+    void putBits(uint32_t value, int count);
+    void putCode(uint32_t code, int length);
+    void putLiteral(int value);
+    void putMatch(int length, int distance);
+    void deflateLine();
+    void updateAdler(const std::vector<uint8_t>& data);
+
+public:
+    ImageWriter(std::ostream& out, ImageFormat format, int width, int height);
+
+    // Append one scanline: width bits packed MSB-first, 1 = dark
+    void writeRow(const std::vector<uint8_t>& row);
+
+    // Write trailing data once every scanline has been written
+    void finish();
+
+    int getRowBytes() const { return rowBytes; }
+};
+
+#endif // IMAGEWRITER_H
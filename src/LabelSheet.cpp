@@ -0,0 +1,239 @@
+#include "LabelSheet.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+
+LabelSheet::LabelSheet(const SheetLayout& layout, ImageFormat format, ErrorCorrectionLevel level)
+    : layout(layout), format(format), ecLevel(level), verifier(nullptr),
+      source(nullptr), requested(0), outstanding(false), bandReady(false), stopping(false) {
+    if (layout.columns <= 0 || layout.rows <= 0 || layout.bandRows <= 0 ||
+        layout.moduleScale <= 0 || layout.quietZone < 0 || layout.gutter < 0) {
+        throw std::runtime_error("Invalid sheet layout");
+    }
+
+    // Every symbol shares the same version, so any instance gives the size
+    symbolSize = QRCode("0", level).getSize();
+
+    // Sizes are worked out in 64 bits so oversized layouts are rejected, not
+    // wrapped; once the label fits in an int, no product below can overflow
+    int64_t labelModules = symbolSize + 2 * int64_t(layout.quietZone);
+    if (labelModules > INT_MAX / layout.moduleScale) {
+        throw std::runtime_error("Invalid sheet layout");
+    }
+    int64_t label = labelModules * layout.moduleScale;
+    int64_t sheetWidth = layout.columns * label + (layout.columns - int64_t(1)) * layout.gutter;
+    int64_t sheetHeight = layout.rows * label + (layout.rows - int64_t(1)) * layout.gutter;
+    int64_t bandSize = int64_t(std::min(layout.bandRows, layout.rows)) * layout.columns;
+    if (sheetWidth > INT_MAX || sheetHeight > INT_MAX || bandSize > INT_MAX) {
+        throw std::runtime_error("Invalid sheet layout");
+    }
+
+    labelSize = static_cast<int>(label);
+    width = static_cast<int>(sheetWidth);
+    height = static_cast<int>(sheetHeight);
+}
+
+LabelSheet::~LabelSheet() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+}
+
+void LabelSheet::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || requested > 0; });
+        if (stopping) return;
+
+        int count = requested;
+        std::istream* payloads = source;
+        requested = 0;
+        lock.unlock();
+
+        std::vector<Label> band;
+        std::exception_ptr error;
+        try {
+            band = encodeBand(*payloads, count);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        readyBand = std::move(band);
+        failure = error;
+        bandReady = true;
+        wake.notify_all();
+    }
+}
+
+void LabelSheet::requestBand(std::istream& payloads, int count) {
+    if (!worker.joinable()) {
+        worker = std::thread(&LabelSheet::workerLoop, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        source = &payloads;
+        requested = count;
+        outstanding = true;
+    }
+    wake.notify_all();
+}
+
+void LabelSheet::waitForBand(std::unique_lock<std::mutex>& lock) {
+    wake.wait(lock, [this] { return bandReady; });
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        bandReady = false;
+        outstanding = false;
+        std::rethrow_exception(error);
+    }
+}
+
+std::vector<LabelSheet::Label> LabelSheet::takeBand() {
+    std::unique_lock<std::mutex> lock(mutex);
+    waitForBand(lock);
+    bandReady = false;
+    outstanding = false;
+    return std::move(readyBand);
+}
+
+void LabelSheet::setVerifier(SymbolVerifier* verifier) {
+    if (worker.joinable()) {
+        throw std::runtime_error("Verifier must be set before the first page");
+    }
+    this->verifier = verifier;
+}
+
+int LabelSheet::bandLabels(int firstRow) const {
+    return std::min(layout.bandRows, layout.rows - firstRow) * layout.columns;
+}
+
+std::vector<LabelSheet::Label> LabelSheet::encodeBand(std::istream& payloads, int count) const {
+    std::vector<Label> band;
+    band.reserve(count);
+
+    std::string line;
+    while (static_cast<int>(band.size()) < count && std::getline(payloads, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        QRCode symbol(line, ecLevel);
+        symbol.generate();
+        VerifyResult result = verifier ? verifier->verify(symbol.getMatrix(), line)
+                                       : VerifyResult::SKIPPED;
+        band.push_back({std::move(symbol), line, result});
+    }
+
+    return band;
+}
+
+void LabelSheet::rasterizeBand(const std::vector<Label>& band, int firstRow, int bandRows,
+                               ImageWriter& writer) const {
+    std::vector<uint8_t> scanline(writer.getRowBytes());
+    const std::vector<uint8_t> blank(writer.getRowBytes(), 0);
+
+    auto fillPixels = [&scanline](int x, int count) {
+        for (int end = x + count; x < end; x++) {
+            scanline[x >> 3] |= 0x80 >> (x & 7);
+        }
+    };
+
+    for (int r = 0; r < bandRows; r++) {
+        for (int moduleRow = -layout.quietZone; moduleRow < symbolSize + layout.quietZone; moduleRow++) {
+            // Build each module row once and repeat it for the module scale
+            std::fill(scanline.begin(), scanline.end(), 0);
+
+            if (moduleRow >= 0 && moduleRow < symbolSize) {
+                for (int c = 0; c < layout.columns; c++) {
+                    size_t index = r * layout.columns + c;
+                    if (index >= band.size()) break;
+
+                    const Label& label = band[index];
+                    if (label.result != VerifyResult::OK && label.result != VerifyResult::SKIPPED) {
+                        continue;
+                    }
+
+                    const auto& modules = label.symbol.getMatrix()[moduleRow];
+                    int left = c * labelSize + c * layout.gutter + layout.quietZone * layout.moduleScale;
+                    for (int col = 0; col < symbolSize; col++) {
+                        if (modules[col] == 1) {
+                            fillPixels(left + col * layout.moduleScale, layout.moduleScale);
+                        }
+                    }
+                }
+            }
+
+            for (int s = 0; s < layout.moduleScale; s++) {
+                writer.writeRow(scanline);
+            }
+        }
+
+        // Gutter between label rows, but not after the last one on the page
+        if (firstRow + r < layout.rows - 1) {
+            for (int g = 0; g < layout.gutter; g++) {
+                writer.writeRow(blank);
+            }
+        }
+    }
+}
+
+int LabelSheet::compose(std::istream& payloads, std::ostream& out) {
+    ImageWriter writer(out, format, width, height);
+    int placed = 0;
+    failures.clear();
+
+    // Reuse the band prefetched at the end of the previous page when it
+    // came from the same stream
+    if (outstanding && source != &payloads) takeBand();
+    if (!outstanding) requestBand(payloads, bandLabels(0));
+
+    bool exhausted = false;
+    for (int row = 0; row < layout.rows; ) {
+        std::vector<Label> band;
+        if (!exhausted) band = takeBand();
+        int bandRows = std::min(layout.bandRows, layout.rows - row);
+
+        // Start encoding the following band (wrapping to the next page)
+        // before writing this one, unless the payload stream has run dry
+        exhausted = static_cast<int>(band.size()) < bandRows * layout.columns;
+        if (!exhausted) {
+            int nextRow = row + bandRows < layout.rows ? row + bandRows : 0;
+            requestBand(payloads, bandLabels(nextRow));
+        }
+
+        for (size_t i = 0; i < band.size(); i++) {
+            VerifyResult result = band[i].result;
+            if (result == VerifyResult::OK || result == VerifyResult::SKIPPED) {
+                placed++;
+            } else {
+                failures.push_back({row + static_cast<int>(i) / layout.columns,
+                                    static_cast<int>(i) % layout.columns,
+                                    band[i].payload, result});
+            }
+        }
+        rasterizeBand(band, row, bandRows, writer);
+        row += bandRows;
+    }
+
+    writer.finish();
+    return placed;
+}
+
+bool LabelSheet::hasPayloads(std::istream& payloads) {
+    // Encode the next page's first band now; blank lines are skipped while
+    // encoding, so an empty band means nothing is left to place
+    if (outstanding && source != &payloads) takeBand();
+    if (!outstanding) requestBand(payloads, bandLabels(0));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    waitForBand(lock);
+    return !readyBand.empty();
+}
@@ -0,0 +1,111 @@
+#ifndef LABELSHEET_H
+#define LABELSHEET_H
+
+#include <condition_variable>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ImageWriter.h"
+#include "QRCode.h"
+#include "SymbolVerifier.h"
+
+struct SheetLayout {
+    int columns = 10;      // Labels per row
+    int rows = 20;         // Label rows per page
+    int bandRows = 1;      // Label rows encoded together as one band
+    int moduleScale = 4;   // Pixels per module
+    int quietZone = 4;     // Blank modules around each symbol
+    int gutter = 8;        // Blank pixels between neighbouring labels
+};
+
+// A label whose symbol failed verification; its cell is left blank
+struct LabelFailure {
+    int row;             // Label row on the page, from 0
+    int column;          // Label column on the page, from 0
+    std::string payload;
+    VerifyResult result;
+};
+
+// Tiles many symbols into one page image. Symbols are generated one band
+// of label rows at a time by a single worker thread that lives for the whole
+// job; the next band (on this page or the next) is encoded while the current
+// one is rasterized and written. Memory stays bounded by two bands, the image
+// writer's scanlines and its PNG output buffer, regardless of page size.
+class LabelSheet {
+private:
+    SheetLayout layout;
+    ImageFormat format;
+    ErrorCorrectionLevel ecLevel;
+    int symbolSize;  // Modules per side
+    int labelSize;   // Pixels per side, including quiet zone
+    int width;
+    int height;
+    SymbolVerifier* verifier;
+    std::vector<LabelFailure> failures;
+
+    // A generated symbol and the outcome of its round-trip check
+    struct Label {
+        QRCode symbol;
+        std::string payload;
+        VerifyResult result;
+    };
+
+    // Band encoder thread; at most one band is requested or ready at a time
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::istream* source;
+    int requested;      // Labels asked for but not yet picked up by the worker
+    bool outstanding;   // A band has been requested and not yet taken
+    bool bandReady;
+    bool stopping;
+    std::vector<Label> readyBand;
+    std::exception_ptr failure;
+
+    void workerLoop();
+    void requestBand(std::istream& payloads, int count);
+    void waitForBand(std::unique_lock<std::mutex>& lock);
+    std::vector<Label> takeBand();
+    int bandLabels(int firstRow) const;
+
+    // Read up to `count` non-empty payload lines and generate their symbols
+    std::vector<Label> encodeBand(std::istream& payloads, int count) const;
+
+    // Emit the scanlines for one band starting at label row `firstRow`
+    void rasterizeBand(const std::vector<Label>& band, int firstRow, int bandRows,
+                       ImageWriter& writer) const;
+
+public:
+    LabelSheet(const SheetLayout& layout, ImageFormat format,
+               ErrorCorrectionLevel level = ErrorCorrectionLevel::M);
+    ~LabelSheet();
+
+    LabelSheet(const LabelSheet&) = delete;
+    LabelSheet& operator=(const LabelSheet&) = delete;
+
+    // Compose one page from payloads read line by line; unused cells stay blank.
+    // Returns the number of labels placed, not counting those that failed verification.
+    int compose(std::istream& payloads, std::ostream& out);
+
+    // Labels left blank on the last composed page because they failed verification
+    const std::vector<LabelFailure>& getFailures() const { return failures; }
+
+    // True if `payloads` still holds a non-blank line, i.e. compose() would place a label.
+    // Once a job has started, only LabelSheet may read from `payloads`.
+    bool hasPayloads(std::istream& payloads);
+
+    // Round-trip every generated symbol through `verifier` (may be null). The
+    // verifier is driven from the worker thread, which may be prefetching the
+    // next page between compose() calls: set it before the first compose() or
+    // hasPayloads(), and read its stats only after this LabelSheet is destroyed.
+    void setVerifier(SymbolVerifier* verifier);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+#endif // LABELSHEET_H
@@ -84,38 +84,95 @@ void QRCode::addDarkModule() {
     matrix[4 * version + 9][8] = 1;
 }
 
-void QRCode::placeDataBits(const std::vector<int>& bits) {
-    int bitIndex = 0;
+std::vector<std::pair<int, int>> QRCode::traceDataModules() const {
+    std::vector<std::pair<int, int>> modules;
     bool up = true;
     
-    // Start from bottom-right, move in zigzag
+    // Start from bottom-right, move in zigzag over the unset cells
     for (int col = size - 1; col > 0; col -= 2) {
         if (col == 6) col--; // Skip timing column
         
         for (int i = 0; i < size; i++) {
             int row = up ? (size - 1 - i) : i;
             
-            // Place in right column of pair
-            if (matrix[row][col] == -1 && bitIndex < static_cast<int>(bits.size())) {
- 
-                matrix[row][col] = bits[bitIndex++];
-            }
-            
-            // Place in left column of pair
-            if (matrix[row][col] == -1 && bitIndex < static_cast<int>(bits.size())) {
-
-                matrix[row][col - 1] = bits[bitIndex++];
-            }
+            // Right column of pair, then left column
+            if (matrix[row][col] == -1) modules.emplace_back(row, col);
+            if (matrix[row][col - 1] == -1) modules.emplace_back(row, col - 1);
         }
         
         up = !up;
     }
     
-    // Fill any remaining cells with 0
-    for (auto& row : matrix) {
-        for (auto& cell : row) {
-            if (cell == -1) cell = 0;
-        }
+    return modules;
+}
+
+int QRCode::formatBits(ErrorCorrectionLevel level, int maskPattern) {
+    int levelBits = 0;
+    switch (level) {
+        case ErrorCorrectionLevel::L: levelBits = 1; break;
+        case ErrorCorrectionLevel::M: levelBits = 0; break;
+        case ErrorCorrectionLevel::Q: levelBits = 3; break;
+        case ErrorCorrectionLevel::H: levelBits = 2; break;
+    }
+    
+    // BCH(15,5) code with generator 0x537, then the fixed XOR mask
+    int data = (levelBits << 3) | maskPattern;
+    int remainder = data;
+    for (int i = 0; i < 10; i++) {
+        remainder = (remainder << 1) ^ ((remainder >> 9) * 0x537);
+    }
+    return ((data << 10) | remainder) ^ 0x5412;
+}
+
+std::vector<std::pair<int, int>> QRCode::formatModules(int size) {
+    // (row, col) of format bits 0-14 for the first copy, then the second copy
+    std::vector<std::pair<int, int>> modules;
+    
+    // First copy, around the top-left finder
+    for (int i = 0; i <= 5; i++) modules.emplace_back(i, 8);
+    modules.emplace_back(7, 8);
+    modules.emplace_back(8, 8);
+    modules.emplace_back(8, 7);
+    for (int i = 9; i < 15; i++) modules.emplace_back(8, 14 - i);
+    
+    // Second copy, split between the top-right and bottom-left finders
+    for (int i = 0; i < 8; i++) modules.emplace_back(8, size - 1 - i);
+    for (int i = 8; i < 15; i++) modules.emplace_back(size - 15 + i, 8);
+    
+    return modules;
+}
+
+void QRCode::reserveFormatInformation() {
+    // Keep data out of the format areas until the mask is known
+    for (const auto& module : formatModules(size)) {
+        matrix[module.first][module.second] = 0;
+    }
+}
+
+void QRCode::addFormatInformation(int maskPattern) {
+    int bits = formatBits(ecLevel, maskPattern);
+    auto modules = formatModules(size);
+    for (size_t i = 0; i < modules.size(); i++) {
+        matrix[modules[i].first][modules[i].second] = (bits >> (i % 15)) & 1;
+    }
+}
+
+std::vector<std::pair<int, int>> QRCode::dataModules() {
+    QRCode layout("0");
+    layout.addFinderPatterns();
+    layout.addSeparators();
+    layout.addTimingPatterns();
+    layout.addDarkModule();
+    layout.reserveFormatInformation();
+    return layout.traceDataModules();
+}
+
+void QRCode::placeDataBits(const std::vector<int>& bits) {
+    auto modules = traceDataModules();
+    
+    // Cells beyond the end of the bit stream are filled with 0
+    for (size_t i = 0; i < modules.size(); i++) {
+        matrix[modules[i].first][modules[i].second] = i < bits.size() ? bits[i] : 0;
     }
 }
 
@@ -130,25 +187,27 @@ void QRCode::applyMask(int maskPattern) {
                 continue;
             }
             
-            bool shouldFlip = false;
-            switch (maskPattern) {
-                case 0: shouldFlip = ((row + col) % 2 == 0); break;
-                case 1: shouldFlip = (row % 2 == 0); break;
-                case 2: shouldFlip = (col % 3 == 0); break;
-                case 3: shouldFlip = ((row + col) % 3 == 0); break;
-                case 4: shouldFlip = ((row / 2 + col / 3) % 2 == 0); break;
-                case 5: shouldFlip = ((row * col) % 2 + (row * col) % 3 == 0); break;
-                case 6: shouldFlip = (((row * col) % 2 + (row * col) % 3) % 2 == 0); break;
-                case 7: shouldFlip = (((row + col) % 2 + (row * col) % 3) % 2 == 0); break;
-            }
-            
-            if (shouldFlip) {
+            if (maskBit(maskPattern, row, col)) {
                 matrix[row][col] ^= 1;
             }
         }
     }
 }
 
+bool QRCode::maskBit(int maskPattern, int row, int col) {
+    switch (maskPattern) {
+        case 0: return ((row + col) % 2 == 0);
+        case 1: return (row % 2 == 0);
+        case 2: return (col % 3 == 0);
+        case 3: return ((row + col) % 3 == 0);
+        case 4: return ((row / 2 + col / 3) % 2 == 0);
+        case 5: return ((row * col) % 2 + (row * col) % 3 == 0);
+        case 6: return (((row * col) % 2 + (row * col) % 3) % 2 == 0);
+        case 7: return (((row + col) % 2 + (row * col) % 3) % 2 == 0);
+    }
+    return false;
+}
+
 int QRCode::calculatePenalty() {
     // Simplified penalty calculation
     int penalty = 0;
@@ -201,6 +260,7 @@ void QRCode::generate() {
     addSeparators();
     addTimingPatterns();
     addDarkModule();
+    reserveFormatInformation();
     
     // Step 3: Encode data
     auto encodedBits = DataEncoder::encodeData(inputData, mode, ecLevel, version);
@@ -211,9 +271,10 @@ void QRCode::generate() {
     // Step 5: Place data bits
     placeDataBits(finalBits);
     
-    // Step 6: Apply best mask
+    // Step 6: Apply best mask and record it in the format information
     int bestMask = selectBestMask();
     applyMask(bestMask);
+    addFormatInformation(bestMask);
 }
 
 void QRCode::printToConsole() {
@@ -2,6 +2,7 @@
 #define QRCODE_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
 enum class EncodingMode {
@@ -33,6 +34,9 @@ private:
     void addSeparators();
     void addTimingPatterns();
     void addDarkModule();
+    void reserveFormatInformation();
+    void addFormatInformation(int maskPattern);
+    std::vector<std::pair<int, int>> traceDataModules() const;
     void placeDataBits(const std::vector<int>& bits);
     void applyMask(int maskPattern);
     int calculatePenalty();
@@ -47,6 +51,14 @@ public:
     
     EncodingMode getMode() const { return mode; }
     int getSize() const { return size; }
+    int getVersion() const { return version; }
+    const std::vector<std::vector<int>>& getMatrix() const { return matrix; }
+
+    // Symbol layout, shared with SymbolVerifier
+    static bool maskBit(int maskPattern, int row, int col);
+    static int formatBits(ErrorCorrectionLevel level, int maskPattern);
+    static std::vector<std::pair<int, int>> formatModules(int size);
+    static std::vector<std::pair<int, int>> dataModules();
 };
 
 #endif // QRCODE_H
\ No newline at end of file
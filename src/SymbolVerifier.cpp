@@ -0,0 +1,142 @@
+#include "SymbolVerifier.h"
+#include "DataEncoder.h"
+#include "ErrorCorrection.h"
+#include <bitset>
+#include <cmath>
+#include <stdexcept>
+
+// Sampling is tracked in millionths so rates are applied exactly
+static const uint32_t SAMPLE_SCALE = 1000000;
+
+// Format information tolerates up to 3 bit errors (BCH(15,5) distance 7)
+static const int MAX_FORMAT_ERRORS = 3;
+
+static const ErrorCorrectionLevel LEVELS[4] = {
+    ErrorCorrectionLevel::L,
+    ErrorCorrectionLevel::M,
+    ErrorCorrectionLevel::Q,
+    ErrorCorrectionLevel::H
+};
+
+SymbolVerifier::SymbolVerifier(double sampleRate)
+    : sampleCredit(0) {
+    if (!(sampleRate >= 0.0 && sampleRate <= 1.0)) {
+        throw std::runtime_error("Sample rate must be between 0 and 1");
+    }
+    sampleStep = static_cast<uint32_t>(std::lround(sampleRate * SAMPLE_SCALE));
+
+    QRCode layout("0");
+    size = layout.getSize();
+    version = layout.getVersion();
+
+    // Placement order and per-mask flips, straight from the generator
+    auto modules = QRCode::dataModules();
+    maskFlips.resize(8);
+    for (const auto& module : modules) {
+        dataRows.push_back(module.first);
+        dataCols.push_back(module.second);
+        for (int mask = 0; mask < 8; mask++) {
+            maskFlips[mask].push_back(QRCode::maskBit(mask, module.first, module.second));
+        }
+    }
+
+    formatPositions = QRCode::formatModules(size);
+    for (auto level : LEVELS) {
+        for (int mask = 0; mask < 8; mask++) {
+            formatCodes.push_back(QRCode::formatBits(level, mask));
+        }
+    }
+}
+
+int SymbolVerifier::nearestFormat(int bits, int& distance) const {
+    int best = 0;
+    distance = 16;
+    for (int i = 0; i < static_cast<int>(formatCodes.size()); i++) {
+        int d = static_cast<int>(std::bitset<15>(bits ^ formatCodes[i]).count());
+        if (d < distance) {
+            distance = d;
+            best = i;
+        }
+    }
+    return best;
+}
+
+VerifyResult SymbolVerifier::decode(const std::vector<std::vector<int>>& matrix,
+                                    std::string& payload) const {
+    if (static_cast<int>(matrix.size()) != size) return VerifyResult::FORMAT_ERROR;
+    for (const auto& row : matrix) {
+        if (static_cast<int>(row.size()) != size) return VerifyResult::FORMAT_ERROR;
+    }
+
+    // Format information: decode both copies and trust the one nearer a valid code
+    int format = 0;
+    int bestDistance = MAX_FORMAT_ERRORS + 1;
+    for (int copy = 0; copy < 2; copy++) {
+        int bits = 0;
+        for (int i = 0; i < 15; i++) {
+            const auto& position = formatPositions[copy * 15 + i];
+            bits |= (matrix[position.first][position.second] & 1) << i;
+        }
+
+        int distance;
+        int code = nearestFormat(bits, distance);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            format = code;
+        }
+    }
+    if (bestDistance > MAX_FORMAT_ERRORS) return VerifyResult::FORMAT_ERROR;
+
+    ErrorCorrectionLevel level = LEVELS[format / 8];
+    int maskPattern = format % 8;
+
+    int dataCodewords = DataEncoder::getCapacity(version, level) / 8;
+    int ecCodewords = ErrorCorrection::getECCodewordCount(level, version);
+    int totalBits = (dataCodewords + ecCodewords) * 8;
+    if (totalBits > static_cast<int>(dataRows.size())) return VerifyResult::FORMAT_ERROR;
+
+    // Unmask and gather codewords in placement order
+    const auto& flips = maskFlips[maskPattern];
+    std::vector<int> codewords(dataCodewords + ecCodewords, 0);
+    for (int i = 0; i < totalBits; i++) {
+        int bit = (matrix[dataRows[i]][dataCols[i]] & 1) ^ flips[i];
+        codewords[i >> 3] |= bit << (7 - (i & 7));
+    }
+
+    if (!ErrorCorrection::checkErrorCorrection(codewords, level, version)) {
+        return VerifyResult::ECC_ERROR;
+    }
+
+    codewords.resize(dataCodewords);
+    if (!DataEncoder::decodeData(codewords, version, payload)) {
+        return VerifyResult::DECODE_ERROR;
+    }
+
+    return VerifyResult::OK;
+}
+
+VerifyResult SymbolVerifier::verify(const std::vector<std::vector<int>>& matrix,
+                                    const std::string& expected) {
+    stats.seen++;
+
+    sampleCredit += sampleStep;
+    if (sampleCredit < SAMPLE_SCALE) return VerifyResult::SKIPPED;
+    sampleCredit -= SAMPLE_SCALE;
+    stats.checked++;
+
+    std::string payload;
+    VerifyResult result = decode(matrix, payload);
+    if (result == VerifyResult::OK && payload != expected) {
+        result = VerifyResult::PAYLOAD_MISMATCH;
+    }
+
+    switch (result) {
+        case VerifyResult::FORMAT_ERROR:     stats.formatErrors++; break;
+        case VerifyResult::ECC_ERROR:        stats.eccErrors++; break;
+        case VerifyResult::DECODE_ERROR:     stats.decodeErrors++; break;
+        case VerifyResult::PAYLOAD_MISMATCH: stats.payloadMismatches++; break;
+        default: break;
+    }
+
+    return result;
+}
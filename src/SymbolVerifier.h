@@ -0,0 +1,65 @@
+#ifndef SYMBOLVERIFIER_H
+#define SYMBOLVERIFIER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "QRCode.h"
+
+enum class VerifyResult {
+    OK,
+    SKIPPED,           // Not selected by the sampling rate
+    FORMAT_ERROR,      // Wrong size or unreadable format information
+    ECC_ERROR,         // Non-zero error correction syndrome
+    DECODE_ERROR,      // Malformed data segments
+    PAYLOAD_MISMATCH   // Decoded cleanly but to a different payload
+};
+
+struct VerifierStats {
+    uint64_t seen = 0;
+    uint64_t checked = 0;
+    uint64_t formatErrors = 0;
+    uint64_t eccErrors = 0;
+    uint64_t decodeErrors = 0;
+    uint64_t payloadMismatches = 0;
+
+    uint64_t failures() const {
+        return formatErrors + eccErrors + decodeErrors + payloadMismatches;
+    }
+};
+
+// Reads a generated module matrix back to its payload: format information,
+// unmasking, the generator's placement order, the error correction check and
+// segment decoding. Layout tables are built once per instance, so reuse one
+// verifier per thread for batch jobs; counters are not synchronized.
+class SymbolVerifier {
+private:
+    int size;
+    int version;
+    std::vector<uint8_t> dataRows;
+    std::vector<uint8_t> dataCols;
+    std::vector<std::vector<uint8_t>> maskFlips;  // Per mask, per data module
+    std::vector<std::pair<int, int>> formatPositions;
+    std::vector<int> formatCodes;  // Indexed by level * 8 + mask
+    uint32_t sampleStep;
+    uint32_t sampleCredit;
+    VerifierStats stats;
+
+    // Index of the valid format code nearest to 15 read bits; sets its Hamming distance
+    int nearestFormat(int bits, int& distance) const;
+
+public:
+    // sampleRate is the fraction of symbols passed to verify() that are decoded
+    explicit SymbolVerifier(double sampleRate = 1.0);
+
+    // Decode a module matrix without sampling or counters
+    VerifyResult decode(const std::vector<std::vector<int>>& matrix, std::string& payload) const;
+
+    // Sampled round-trip check against the payload the symbol was generated from
+    VerifyResult verify(const std::vector<std::vector<int>>& matrix, const std::string& expected);
+
+    const VerifierStats& getStats() const { return stats; }
+    void resetStats() { stats = VerifierStats(); }
+};
+
+#endif // SYMBOLVERIFIER_H
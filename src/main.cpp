@@ -1,7 +1,222 @@
 #include "QRCode.h"
+#include "LabelSheet.h"
+#include "SymbolVerifier.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <string>
+
+// Parse a whole argument as an integer
+static bool parseInt(const std::string& text, int& value) {
+    try {
+        size_t used = 0;
+        value = std::stoi(text, &used);
+        return used == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Parse a whole argument as a floating-point number
+static bool parseDouble(const std::string& text, double& value) {
+    try {
+        size_t used = 0;
+        value = std::stod(text, &used);
+        return used == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Short description of a failed round trip
+static const char* resultName(VerifyResult result) {
+    switch (result) {
+        case VerifyResult::OK:               return "ok";
+        case VerifyResult::SKIPPED:          return "skipped";
+        case VerifyResult::FORMAT_ERROR:     return "format error";
+        case VerifyResult::ECC_ERROR:        return "ECC error";
+        case VerifyResult::DECODE_ERROR:     return "decode error";
+        case VerifyResult::PAYLOAD_MISMATCH: return "payload mismatch";
+    }
+    return "unknown";
+}
+
+// Compose label sheets from a file of payloads, one per line
+static int runSheet(int argc, char* argv[]) {
+    const char* usage = " --sheet <payloads.txt> <output-stem> [png|pbm] [columns] [rows]"
+                        " [--gutter px] [--scale px] [--quiet-zone modules] [--band-rows rows]\n";
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 1;
+    }
+
+    std::ifstream payloads(argv[2]);
+    if (!payloads) {
+        std::cerr << "Error: Could not open file " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::string stem = argv[3];
+    std::string extension = "png";
+    SheetLayout layout;
+
+    // Positional format, columns and rows; layout options may appear anywhere after the stem
+    int positional = 0;
+    for (int i = 4; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) == 0) {
+            int* target = nullptr;
+            if (arg == "--gutter") target = &layout.gutter;
+            else if (arg == "--scale") target = &layout.moduleScale;
+            else if (arg == "--quiet-zone") target = &layout.quietZone;
+            else if (arg == "--band-rows") target = &layout.bandRows;
+
+            if (!target) {
+                std::cerr << "Error: Unknown option " << arg << "\n";
+                return 1;
+            }
+            if (i + 1 >= argc || !parseInt(argv[++i], *target)) {
+                std::cerr << "Error: " << arg << " needs a whole number\n";
+                return 1;
+            }
+            continue;
+        }
+
+        switch (positional++) {
+            case 0:
+                extension = arg;
+                break;
+            case 1:
+                if (!parseInt(arg, layout.columns)) {
+                    std::cerr << "Error: Columns must be a whole number\n";
+                    return 1;
+                }
+                break;
+            case 2:
+                if (!parseInt(arg, layout.rows)) {
+                    std::cerr << "Error: Rows must be a whole number\n";
+                    return 1;
+                }
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << usage;
+                return 1;
+        }
+    }
+
+    ImageFormat format = ImageFormat::PNG;
+    if (extension == "pbm") {
+        format = ImageFormat::PBM;
+    } else if (extension != "png") {
+        std::cerr << "Error: Unknown image format " << extension << "\n";
+        return 1;
+    }
+
+    SymbolVerifier verifier;
+    int page = 0;
+    int total = 0;
+    std::string filename;
+    try {
+        LabelSheet sheet(layout, format, ErrorCorrectionLevel::M);
+        sheet.setVerifier(&verifier);
+        while (sheet.hasPayloads(payloads)) {
+            filename = stem + "_" + std::to_string(++page) + "." + extension;
+            std::ofstream out(filename, std::ios::binary);
+            if (!out) {
+                std::cerr << "Error: Could not open file " << filename << "\n";
+                return 1;
+            }
+
+            int placed = sheet.compose(payloads, out);
+            total += placed;
+            std::cout << "Sheet saved to " << filename << " (" << placed << " labels, "
+                      << sheet.getWidth() << "x" << sheet.getHeight() << ")\n";
+            for (const LabelFailure& failure : sheet.getFailures()) {
+                std::cerr << "Verification failed (" << resultName(failure.result) << "), left blank: "
+                          << filename << " row " << failure.row + 1
+                          << " column " << failure.column + 1 << ": " << failure.payload << "\n";
+            }
+            filename.clear();
+        }
+    } catch (const std::exception& e) {
+        // Don't leave a truncated page behind
+        if (!filename.empty()) std::remove(filename.c_str());
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << total << " labels on " << page << " sheet(s), "
+              << verifier.getStats().failures() << " failed verification and left blank\n";
+    return verifier.getStats().failures() == 0 ? 0 : 2;
+}
+
+// Generate a symbol for every payload and decode it back
+static int runVerify(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --verify <payloads.txt> [sample-rate]\n";
+        return 1;
+    }
+
+    std::ifstream payloads(argv[2]);
+    if (!payloads) {
+        std::cerr << "Error: Could not open file " << argv[2] << "\n";
+        return 1;
+    }
+
+    double sampleRate = 1.0;
+    if (argc > 3 && !parseDouble(argv[3], sampleRate)) {
+        std::cerr << "Error: Sample rate must be a number\n";
+        return 1;
+    }
+    if (!(sampleRate >= 0.0 && sampleRate <= 1.0)) {
+        std::cerr << "Error: Sample rate must be between 0 and 1\n";
+        return 1;
+    }
+
+    SymbolVerifier verifier(sampleRate);
+    std::chrono::steady_clock::duration elapsed{};
+
+    std::string line;
+    while (std::getline(payloads, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        QRCode qr(line, ErrorCorrectionLevel::M);
+        qr.generate();
+
+        auto start = std::chrono::steady_clock::now();
+        VerifyResult result = verifier.verify(qr.getMatrix(), line);
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        if (result != VerifyResult::OK && result != VerifyResult::SKIPPED) {
+            std::cerr << "Verification failed (" << resultName(result) << "): " << line << "\n";
+        }
+    }
+
+    const VerifierStats& stats = verifier.getStats();
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << "Seen: " << stats.seen << ", checked: " << stats.checked << "\n"
+              << "Format errors: " << stats.formatErrors
+              << ", ECC errors: " << stats.eccErrors
+              << ", decode errors: " << stats.decodeErrors
+              << ", payload mismatches: " << stats.payloadMismatches << "\n";
+    if (seconds > 0) {
+        std::cout << "Verified " << static_cast<long long>(stats.checked / seconds)
+                  << " symbols/s\n";
+    }
+
+    return stats.failures() == 0 ? 0 : 2;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--sheet") {
+        return runSheet(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--verify") {
+        return runVerify(argc, argv);
+    }
 
-int main() {
     std::string input;
 
     std::cout << "Enter text to encode in QR: ";
@@ -19,4 +234,4 @@ int main() {
     qr.saveToFile("qrcode_output.txt");
 
     return 0;
-}
+}
\ No newline at end of file